@@ -0,0 +1,16 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+namespace Wav {
+
+// Minimal bfloat16, i.e. the upper 16 bits of an IEEE f32. Usable as a read destination, values
+// are produced by Internal::convert. No arithmetic, convert to float for that.
+struct BFloat16 {
+    uint16_t bits;
+
+    explicit operator float() const { return std::bit_cast<float>(static_cast<uint32_t>(bits) << 16); }
+};
+
+} // namespace Wav
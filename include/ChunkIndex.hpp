@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace Wav {
+
+// Location of a RIFF chunk in the file. The offset points at the payload, i.e. past the 8 byte chunk
+// header, and the size excludes the pad byte of odd sized chunks.
+struct Chunk {
+    uint32_t id;
+    std::size_t offset;
+    std::size_t size;
+};
+
+// All chunks in file order, as recorded by infer
+using ChunkIndex = std::vector<Chunk>;
+
+// Finds the first chunk with the given four character id, e.g. "LIST", "bext", "cue " or "smpl"
+static std::optional<Chunk> findChunk(const ChunkIndex& index, std::string_view id)
+{
+    if (id.size() != 4) {
+        return std::nullopt;
+    }
+    uint32_t key = (uint8_t(id[3]) << 24) | (uint8_t(id[2]) << 16) | (uint8_t(id[1]) << 8) | uint8_t(id[0]);
+    for (const Chunk& chunk : index) {
+        if (chunk.id == key) {
+            return chunk;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace Wav
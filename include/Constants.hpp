@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -12,6 +13,9 @@ const uint32_t DATA = ('a' << 24) | ('t' << 16) | ('a' << 8) | 'd';
 const uint32_t RIFF = ('F' << 24) | ('F' << 16) | ('I' << 8) | 'R';
 const uint32_t WAVE = ('E' << 24) | ('V' << 16) | ('A' << 8) | 'W';
 
+// Number of frames read + mixed at a time by readMixed
+const std::size_t MIX_BLOCK_FRAMES = 4096;
+
 static std::string idString(uint32_t id)
 {
     char chars[4];
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "BFloat16.hpp"
 #include "Variadic.hpp"
 
-#include <iostream>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace Wav::Internal {
 
@@ -12,7 +17,6 @@ requires(
     (std::is_same<T, double>::value or std::is_same<T, float>::value))
 inline T convert(K x)
 {
-    std::cout << "converting floating point" << std::endl;
     return static_cast<T>(x);
 }
 
@@ -20,7 +24,6 @@ template <typename K, typename T>
 requires((std::is_same<K, uint8_t>::value) and (std::is_same<T, double>::value or std::is_same<T, float>::value))
 inline T convert(K x)
 {
-    std::cout << "converting u8" << std::endl;
     // Convert uint8_t to float in the range [0, 1]
     return (static_cast<T>(x) - 128.0f) / 127.0f;
 }
@@ -29,11 +32,127 @@ template <typename K, typename T>
 requires((std::is_same<K, int16_t>::value) and (std::is_same<T, double>::value or std::is_same<T, float>::value))
 inline T convert(K x)
 {
-    std::cout << "converting s16" << std::endl;
     // Convert int16_t to float in the range [-1, 1]
     return static_cast<T>(x) / 32767.0f;
 }
 
+// Reduced precision destinations. Samples are brought to float (double stays double) and then
+// narrowed, rounding to nearest even. int16_t saturates.
+template <typename K, typename T>
+requires((std::is_same<K, int16_t>::value) and (std::is_same<T, int16_t>::value))
+inline T convert(K x)
+{
+    return x;
+}
+
+template <typename K, typename T>
+requires(
+    (std::is_same<K, double>::value or std::is_same<K, float>::value) and (std::is_same<T, int16_t>::value))
+inline T convert(K x)
+{
+    // Inverse of the s16 -> float conversion, NaN maps to 0
+    K y = std::nearbyint(x * static_cast<K>(32767));
+    if (y >= static_cast<K>(32767)) {
+        return 32767;
+    }
+    if (y <= static_cast<K>(-32768)) {
+        return -32768;
+    }
+    if (y != y) {
+        return 0;
+    }
+    return static_cast<T>(y);
+}
+
+template <typename K, typename T>
+requires((std::is_same<K, uint8_t>::value) and (std::is_same<T, int16_t>::value))
+inline T convert(K x)
+{
+    // Same mapping as going through float, so read and readMixed agree
+    return convert<float, T>(convert<K, float>(x));
+}
+
+#ifdef __FLT16_MAX__
+template <typename K, typename T>
+requires(
+    (std::is_same<K, uint8_t>::value or std::is_same<K, int16_t>::value or std::is_same<K, float>::value or
+     std::is_same<K, double>::value) and
+    (std::is_same<T, _Float16>::value))
+inline T convert(K x)
+{
+    // The cast lowers to F16C / AVX512-FP16 instructions when the target has them, and to a
+    // correctly rounded software conversion otherwise
+    using F = std::conditional_t<std::is_same<K, double>::value, double, float>;
+    return static_cast<T>(convert<K, F>(x));
+}
+#endif
+
+// Narrows a double to float rounding to odd, such that rounding the result again to bfloat16 gives
+// the same result as rounding the double directly.
+inline float narrowToOdd(double x)
+{
+    float f = static_cast<float>(x);
+    if (std::isfinite(f) and static_cast<double>(f) != x) {
+        if (std::abs(static_cast<double>(f)) > std::abs(x)) {
+            f = std::nextafter(f, 0.0f);
+        }
+        f = std::bit_cast<float>(std::bit_cast<uint32_t>(f) | 1u);
+    }
+    return f;
+}
+
+template <typename K, typename T>
+requires(
+    (std::is_same<K, uint8_t>::value or std::is_same<K, int16_t>::value or std::is_same<K, float>::value or
+     std::is_same<K, double>::value) and
+    (std::is_same<T, BFloat16>::value))
+inline T convert(K x)
+{
+    float f;
+    if constexpr (std::is_same<K, double>::value) {
+        f = narrowToOdd(x);
+    } else {
+        f = convert<K, float>(x);
+    }
+    // Round to nearest even in software, also correct for subnormals, where the hardware conversion
+    // (vcvtneps2bf16) flushes to zero. Plain integer ops, so loops over it can auto-vectorize.
+    uint32_t bits = std::bit_cast<uint32_t>(f);
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+        // Keep NaNs quiet NaNs, rounding could carry them into infinity
+        return T{static_cast<uint16_t>((bits >> 16) | 0x0040)};
+    }
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    return T{static_cast<uint16_t>(bits >> 16)};
+}
+
+// Type that is summed into when mixing, reduced precision destinations accumulate in float
+template <typename T>
+struct Accumulator {
+    using type = T;
+};
+
+template <>
+struct Accumulator<int16_t> {
+    using type = float;
+};
+
+template <>
+struct Accumulator<BFloat16> {
+    using type = float;
+};
+
+#ifdef __FLT16_MAX__
+template <>
+struct Accumulator<_Float16> {
+    using type = float;
+};
+#endif
+
+// Type a mix into outputs with the given element types accumulates in, double if any of them needs
+// it, float otherwise
+template <typename... T>
+using MixAccumulator = std::common_type_t<typename Accumulator<T>::type...>;
+
 template <typename K, typename T>
 inline T convert(K x)
 {
@@ -50,13 +169,7 @@ inline void deinterleave(K& interleaved, T& x, std::size_t& i, std::size_t j)
     using K_t = std::remove_reference<decltype(interleaved[0])>::type;
     using T_t = std::remove_reference<decltype(x[0])>::type;
 
-    std::cout << interleaved[i] << std::endl;
-
-    std::cout << x[j] << std::endl;
-
     x[j] = convert<K_t, T_t>(interleaved[i++]);
-
-    std::cout << x[j] << std::endl;
 }
 
 template <typename K, typename... T>
@@ -68,6 +181,44 @@ void deinterleave(K& interleaved, T&... x)
     }
 }
 
+// Downmixing in two template functions, the weights are the mix matrix with the gain folded in
+// (row-major, one row per output). Each frame is converted once into a small scratch buffer and
+// mixed straight into the outputs, so the planar N channel data is never materialized.
+template <typename A, typename T>
+inline void downmix(const A* frame, std::size_t channelCount, const A* weights, T& x, std::size_t& k, std::size_t j)
+{
+    using T_t = std::remove_reference<decltype(x[0])>::type;
+
+    const A* w = weights + channelCount * k++;
+    A acc = 0;
+    for (std::size_t c = 0; c < channelCount; c++) {
+        acc += w[c] * frame[c];
+    }
+    x[j] = convert<A, T_t>(acc);
+}
+
+// Mixes sampleCount interleaved frames into the outputs, starting at output index offset. The
+// weights are already in the accumulator type, see MixAccumulator.
+template <typename A, typename K, typename... T>
+void downmix(
+    const K* interleaved,
+    std::size_t offset,
+    std::size_t sampleCount,
+    std::size_t channelCount,
+    const std::vector<A>& weights,
+    T&... x)
+{
+    std::vector<A> frame(channelCount);
+    for (std::size_t j = 0; j < sampleCount; j++) {
+        const K* in = interleaved + channelCount * j;
+        for (std::size_t c = 0; c < channelCount; c++) {
+            frame[c] = convert<K, A>(in[c]);
+        }
+        std::size_t k = 0;
+        (downmix(frame.data(), channelCount, weights.data(), x, k, offset + j), ...);
+    }
+}
+
 // Interleaving in two template functions
 // TODO: casting interface for different types
 // TODO: container of containers support
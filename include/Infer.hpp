@@ -1,16 +1,20 @@
 #pragma once
 
+#include <algorithm>
 #include <optional>
 
+#include "ChunkIndex.hpp"
+#include "FileDescriptor.hpp"
 #include "Format.hpp"
 #include "IO.hpp"
 
 namespace Wav {
+namespace Internal {
 
-// Infer properties
-// TODO: We currently break after the data field. I'm not sure that this is correct, really. Its
-// just general laziness for now.
-static void infer(std::istream& stream, FileDescriptor& descriptor)
+// Infer properties. Without an index we stop at the data chunk, with one we keep walking the chunk
+// headers up to the end of the RIFF form and record where every chunk lives. Payloads other than
+// 'fmt ' are skipped over, never read.
+static void infer(std::istream& stream, FileDescriptor& descriptor, ChunkIndex* index)
 {
     // ensure the stream is in binary mode if necessary
     stream.seekg(0, std::ios::end);
@@ -23,6 +27,9 @@ static void infer(std::istream& stream, FileDescriptor& descriptor)
     // read the descriptor header
     auto descriptorHeader = Internal::DescriptorHeader{};
     Internal::readDescriptorHeader(stream, descriptorHeader);
+    if (index) {
+        index->clear();
+    }
 
     // now, we read various headers.
     // there can be a bunch, most we dont give a fuck about
@@ -33,6 +40,10 @@ static void infer(std::istream& stream, FileDescriptor& descriptor)
     std::optional<Internal::DataFormat> format;
     bool foundFMT = false;
     bool foundDATA = false;
+    // the RIFF form can be followed by other data (e.g. ID3 tags), once the 'data' chunk is found we stop
+    // at its end. Before that only the stream end counts, some writers leave the RIFF size zero or wrong.
+    std::size_t end = length;
+    std::size_t riffEnd = std::min<std::size_t>(end, 8 + std::size_t(descriptorHeader.chunkSize));
     while (true) {
         Internal::RIFFHeader riff;
         if (!stream.read(reinterpret_cast<char*>(&riff), Internal::getSizeBytes(riff))) {
@@ -43,7 +54,16 @@ static void infer(std::istream& stream, FileDescriptor& descriptor)
             }
         }
 
-        if (riff.chunkId == Internal::FMT0 or riff.chunkId == Internal::FMT1) {
+        // chunks are word aligned, odd sized chunks are followed by a pad byte. Sizes running past the end
+        // of the stream (a missing pad byte, streaming writers using 0xFFFFFFFF) are clamped.
+        std::size_t offset = stream.tellg();
+        std::size_t next = offset + riff.chunkSize + (riff.chunkSize & 1);
+        if (index) {
+            index->push_back(Chunk{riff.chunkId, offset, std::min<std::size_t>(riff.chunkSize, end - offset)});
+        }
+
+        // only the first 'fmt ' and 'data' chunks describe the audio, later ones are just indexed
+        if ((riff.chunkId == Internal::FMT0 or riff.chunkId == Internal::FMT1) and !foundFMT) {
             auto formatChunk = Internal::getFormat(riff.chunkSize);
             std::visit(
                 Internal::overloaded{
@@ -71,10 +91,7 @@ static void infer(std::istream& stream, FileDescriptor& descriptor)
                 },
                 std::move(formatChunk));
             foundFMT = true;
-            continue;
-        }
-
-        if (riff.chunkId == Internal::DATA) {
+        } else if (riff.chunkId == Internal::DATA and !foundDATA) {
             if (!format.has_value()) {
                 throw std::runtime_error("got 'DATA' chunk before 'fmt ' chunk");
             }
@@ -84,13 +101,22 @@ static void infer(std::istream& stream, FileDescriptor& descriptor)
                     descriptor.dataOffset = stream.tellg();
                 },
                 format.value());
+            descriptor.format = format.value();
             foundDATA = true;
-            break;
+            if (!index) {
+                break;
+            }
         }
 
-        stream.seekg(riff.chunkSize, std::ios::cur);
+        if (next >= end or (foundDATA and next >= riffEnd)) {
+            break;
+        }
+        stream.seekg(next);
     }
 
+    // walking up to the end of the file leaves the stream in a failed state
+    stream.clear();
+
     if (!foundFMT) {
         throw std::runtime_error("failed to find 'fmt ' chunk");
     }
@@ -99,6 +125,19 @@ static void infer(std::istream& stream, FileDescriptor& descriptor)
     }
 }
 
+} // namespace Internal
+
+static void infer(std::istream& stream, FileDescriptor& descriptor)
+{
+    Internal::infer(stream, descriptor, nullptr);
+}
+
+// Same as above, but also records the location of every chunk in the file
+static void infer(std::istream& stream, FileDescriptor& descriptor, ChunkIndex& index)
+{
+    Internal::infer(stream, descriptor, &index);
+}
+
 static void infer(const std::string& path, FileDescriptor& descriptor)
 {
     std::ifstream stream(path, std::ios::binary);
@@ -108,4 +147,13 @@ static void infer(const std::string& path, FileDescriptor& descriptor)
     infer(stream, descriptor);
 }
 
+static void infer(const std::string& path, FileDescriptor& descriptor, ChunkIndex& index)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("failed to open file at " + std::string(path));
+    }
+    infer(stream, descriptor, index);
+}
+
 } // namespace Wav
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+
+namespace Wav {
+
+// Mix applied while decoding, maps the N channels in the file onto M output containers.
+// matrix[k][c] is the weight of file channel c in output k, gain[k] is applied on top of row k.
+struct Mix {
+    std::vector<std::vector<double>> matrix;
+    std::vector<double> gain;
+};
+
+} // namespace Wav
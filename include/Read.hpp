@@ -1,9 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
+#include "ChunkIndex.hpp"
+#include "Constants.hpp"
+#include "FileDescriptor.hpp"
 #include "Format.hpp"
+#include "Mix.hpp"
 #include "Variadic.hpp"
 
 namespace Wav {
@@ -53,6 +58,89 @@ void read(std::istream& stream, T&... x)
         descriptor.format);
 }
 
+// Read with a mix applied, one output container per row of the mix matrix. The matrix needs a
+// column per channel in the file. Samples past the end of the file, or past a truncated data chunk,
+// are left untouched.
+template <typename... T>
+void readMixed(std::istream& stream, const Mix& mix, T&... x)
+{
+    // ensure the stream is in binary mode if necessary
+    stream.seekg(0, std::ios::end);
+    std::streampos length = stream.tellg();
+    stream.seekg(0, std::ios::beg);
+    if (length == -1) {
+        throw std::runtime_error("failed to determine stream length");
+    }
+
+    if (!Internal::allSizeEqual(x...)) {
+        throw std::runtime_error("output containers unequally sized");
+    }
+
+    std::size_t outputCount = sizeof...(x);
+    if (mix.matrix.size() != outputCount) {
+        throw std::runtime_error(
+            "provided " + std::to_string(outputCount) + " output containers, mix matrix has " +
+            std::to_string(mix.matrix.size()) + " rows");
+    }
+    if (mix.gain.size() != outputCount) {
+        throw std::runtime_error(
+            "provided " + std::to_string(outputCount) + " output containers, mix has " + std::to_string(mix.gain.size()) +
+            " gains");
+    }
+
+    FileDescriptor descriptor;
+    infer(stream, descriptor);
+    std::size_t channelCount = descriptor.channelCount;
+
+    // fold the gain into the matrix, row-major, converted once to the type the mix accumulates in
+    using A_t = Internal::MixAccumulator<std::remove_reference_t<decltype(x[0])>...>;
+    std::vector<A_t> weights(outputCount * channelCount);
+    for (std::size_t k = 0; k < outputCount; k++) {
+        if (mix.matrix[k].size() != channelCount) {
+            throw std::runtime_error(
+                "mix matrix row " + std::to_string(k) + " has " + std::to_string(mix.matrix[k].size()) +
+                " columns, file contains " + std::to_string(channelCount) + " channels");
+        }
+        for (std::size_t c = 0; c < channelCount; c++) {
+            weights[k * channelCount + c] = static_cast<A_t>(mix.gain[k] * mix.matrix[k][c]);
+        }
+    }
+
+    // clamp to what the file actually holds, the header may overstate it for cut off recordings
+    std::size_t sampleBytes = std::visit([](auto&& format) { return format.sampleBits / 8; }, descriptor.format);
+    std::size_t availableCount = (std::size_t(length) - descriptor.dataOffset) / (channelCount * sampleBytes);
+    std::size_t sampleCount = std::min({Internal::getSize(x...), descriptor.sampleCount, availableCount});
+
+    // read + mix the data block in fixed size blocks of frames, reusing a single buffer
+    stream.seekg(descriptor.dataOffset);
+    std::visit(
+        [&stream, &weights, sampleCount, channelCount, &x...](auto&& format) {
+            using SampleType = typename std::remove_reference_t<decltype(format)>::SampleType;
+            std::size_t blockFrames = std::min(sampleCount, Internal::MIX_BLOCK_FRAMES);
+            auto block = std::unique_ptr<SampleType[]>(new SampleType[blockFrames * channelCount]);
+            for (std::size_t offset = 0; offset < sampleCount; offset += blockFrames) {
+                std::size_t frameCount = std::min(blockFrames, sampleCount - offset);
+                std::size_t byteCount = frameCount * channelCount * (format.sampleBits / 8);
+                if (!stream.read(reinterpret_cast<char*>(block.get()), byteCount)) {
+                    throw std::runtime_error("failed to read 'data' chunk");
+                }
+                Internal::downmix(block.get(), offset, frameCount, channelCount, weights, x...);
+            }
+        },
+        descriptor.format);
+}
+
+// Read the payload of a single chunk recorded by infer, one seek + one read
+static void readChunk(std::istream& stream, const Chunk& chunk, std::vector<char>& payload)
+{
+    payload.resize(chunk.size);
+    stream.clear();
+    stream.seekg(chunk.offset);
+    if (!stream.read(payload.data(), chunk.size)) {
+        throw std::runtime_error("failed to read chunk " + Internal::idString(chunk.id));
+    }
+}
+
 // Helper, usually what you'd do
 template <typename... T>
 void read(std::string& path, T&... x)
@@ -64,4 +152,23 @@ void read(std::string& path, T&... x)
     read(stream, x...);
 }
 
+template <typename... T>
+void readMixed(std::string& path, const Mix& mix, T&... x)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("failed to open file at " + std::string(path));
+    }
+    readMixed(stream, mix, x...);
+}
+
+static void readChunk(const std::string& path, const Chunk& chunk, std::vector<char>& payload)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("failed to open file at " + std::string(path));
+    }
+    readChunk(stream, chunk, payload);
+}
+
 } // namespace Wav
@@ -13,12 +13,15 @@
 #include <vector>
 */
 
+#include "BFloat16.hpp"
+#include "ChunkIndex.hpp"
 #include "Constants.hpp"
 #include "Data.hpp"
 #include "FileDescriptor.hpp"
 #include "Format.hpp"
 #include "Header.hpp"
 #include "Infer.hpp"
+#include "Mix.hpp"
 #include "Read.hpp"
 #include "Variadic.hpp"
 #include "Write.hpp"
@@ -12,7 +12,12 @@ int main(int argv, char** argc)
         if (!file) {
             throw std::runtime_error("failed to open file at " + std::string(argc[1]));
         }
-        Wav::infer(file, descriptor);
+        Wav::ChunkIndex index;
+        Wav::infer(file, descriptor, index);
+        for (const Wav::Chunk& chunk : index) {
+            std::cout << "Chunk '" << Wav::Internal::idString(chunk.id) << "': " << chunk.size << " bytes at offset "
+                      << chunk.offset << std::endl;
+        }
         std::cout << "Sample Rate: " << descriptor.sampleRate << std::endl;
         std::cout << "Sample Count: " << descriptor.sampleCount << " samples" << std::endl;
         std::cout << "Sample Count: " << float(descriptor.sampleCount) * (1.0 / float(descriptor.sampleRate)) << " seconds"
@@ -1,5 +1,6 @@
 #define CATCH_CONFIG_MAIN 
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
 #include <memory>
 #include <fstream>
 #include <sstream>
@@ -37,3 +38,201 @@ TEST_CASE("Binary read") {
         REQUIRE(output[i] == binaryArray[i]);   
     }
 }
+
+TEST_CASE("Mixed read") {
+    std::string filePath = "tests/files/48000Hz_16bit_signed_2ch.wav";
+
+    Wav::FileDescriptor descriptor;
+    std::ifstream fileStream(filePath, std::ios::binary);
+    REQUIRE(fileStream.is_open());
+    Wav::infer(fileStream, descriptor);
+
+    // Reference: read planar, mix afterwards
+    auto left = std::vector<float>(descriptor.sampleCount);
+    auto right = std::vector<float>(descriptor.sampleCount);
+    Wav::read(fileStream, left, right);
+
+    // Fused: mono and swapped-and-scaled stereo in a single pass
+    Wav::Mix mix;
+    mix.matrix = {{0.5, 0.5}, {0.0, 1.0}};
+    mix.gain = {1.0, 0.25};
+    auto mono = std::vector<float>(descriptor.sampleCount);
+    auto scaled = std::vector<float>(descriptor.sampleCount);
+    Wav::readMixed(fileStream, mix, mono, scaled);
+
+    for (std::size_t i = 0; i < descriptor.sampleCount; i++) {
+        REQUIRE(std::abs(mono[i] - (0.5f * left[i] + 0.5f * right[i])) < 1e-6f);
+        REQUIRE(std::abs(scaled[i] - 0.25f * right[i]) < 1e-6f);
+    }
+
+    // Mix matrix must match the channels in the file
+    mix.matrix = {{1.0}, {1.0}};
+    REQUIRE_THROWS(Wav::readMixed(fileStream, mix, mono, scaled));
+
+    // A cut off recording mixes the frames that are there, 100 bytes is 25 frames
+    std::ifstream file(filePath, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::istringstream truncated(bytes.substr(0, bytes.size() - 100));
+    mix.matrix = {{1.0, 0.0}, {0.0, 1.0}};
+    mix.gain = {1.0, 1.0};
+    auto mixedLeft = std::vector<float>(descriptor.sampleCount, 2.0f);
+    auto mixedRight = std::vector<float>(descriptor.sampleCount, 2.0f);
+    Wav::readMixed(truncated, mix, mixedLeft, mixedRight);
+    for (std::size_t i = 0; i < descriptor.sampleCount; i++) {
+        bool present = i < descriptor.sampleCount - 25;
+        REQUIRE(mixedLeft[i] == (present ? left[i] : 2.0f));
+        REQUIRE(mixedRight[i] == (present ? right[i] : 2.0f));
+    }
+}
+
+TEST_CASE("Reduced precision read") {
+    std::string filePath = "tests/files/48000Hz_16bit_signed_1ch.wav";
+
+    Wav::FileDescriptor descriptor;
+    std::ifstream fileStream(filePath, std::ios::binary);
+    REQUIRE(fileStream.is_open());
+    Wav::infer(fileStream, descriptor);
+
+    auto reference = std::vector<float>(descriptor.sampleCount);
+    Wav::read(fileStream, reference);
+
+    // s16 -> s16 is lossless, and round trips through float
+    auto s16 = std::vector<int16_t>(descriptor.sampleCount);
+    Wav::read(fileStream, s16);
+    for (std::size_t i = 0; i < descriptor.sampleCount; i++) {
+        REQUIRE(static_cast<float>(s16[i]) / 32767.0f == reference[i]);
+        REQUIRE(Wav::Internal::convert<float, int16_t>(reference[i]) == s16[i]);
+    }
+
+    // bfloat16 keeps 8 significant bits
+    auto bf16 = std::vector<Wav::BFloat16>(descriptor.sampleCount);
+    Wav::read(fileStream, bf16);
+    for (std::size_t i = 0; i < descriptor.sampleCount; i++) {
+        REQUIRE(std::abs(static_cast<float>(bf16[i]) - reference[i]) <= std::abs(reference[i]) * 0x1p-8f);
+    }
+
+#ifdef __FLT16_MAX__
+    // float16 keeps 11 significant bits
+    auto f16 = std::vector<_Float16>(descriptor.sampleCount);
+    Wav::read(fileStream, f16);
+    for (std::size_t i = 0; i < descriptor.sampleCount; i++) {
+        REQUIRE(std::abs(static_cast<float>(f16[i]) - reference[i]) <= std::abs(reference[i]) * 0x1p-11f);
+    }
+#endif
+
+    // u8 and f32 sources narrow the same way as going through float
+    for (std::string source : {"tests/files/48000Hz_8bit_unsigned_1ch.wav", "tests/files/48000Hz_32bit_float_1ch.wav"}) {
+        std::ifstream sourceStream(source, std::ios::binary);
+        REQUIRE(sourceStream.is_open());
+        Wav::infer(sourceStream, descriptor);
+
+        auto f32 = std::vector<float>(descriptor.sampleCount);
+        auto i16 = std::vector<int16_t>(descriptor.sampleCount);
+        auto b16 = std::vector<Wav::BFloat16>(descriptor.sampleCount);
+        Wav::read(sourceStream, f32);
+        Wav::read(sourceStream, i16);
+        Wav::read(sourceStream, b16);
+        for (std::size_t i = 0; i < descriptor.sampleCount; i++) {
+            REQUIRE(i16[i] == Wav::Internal::convert<float, int16_t>(f32[i]));
+            REQUIRE(b16[i].bits == Wav::Internal::convert<float, Wav::BFloat16>(f32[i]).bits);
+        }
+
+        // An identity mix gives the same result as a plain read
+        Wav::Mix mix;
+        mix.matrix = {{1.0}, {1.0}};
+        mix.gain = {1.0, 1.0};
+        auto mixedI16 = std::vector<int16_t>(descriptor.sampleCount);
+        auto mixedB16 = std::vector<Wav::BFloat16>(descriptor.sampleCount);
+        Wav::readMixed(sourceStream, mix, mixedI16, mixedB16);
+        for (std::size_t i = 0; i < descriptor.sampleCount; i++) {
+            REQUIRE(mixedI16[i] == i16[i]);
+            REQUIRE(mixedB16[i].bits == b16[i].bits);
+        }
+    }
+
+    // Saturation, rounding to nearest even and NaN handling
+    REQUIRE(Wav::Internal::convert<double, int16_t>(2.0) == 32767);
+    REQUIRE(Wav::Internal::convert<double, int16_t>(-2.0) == -32768);
+    REQUIRE(Wav::Internal::convert<float, int16_t>(NAN) == 0);
+    REQUIRE(Wav::Internal::convert<uint8_t, int16_t>(255) == 32767);
+    REQUIRE(Wav::Internal::convert<uint8_t, int16_t>(128) == 0);
+    REQUIRE(Wav::Internal::convert<float, Wav::BFloat16>(1.0f + 0x1p-8f).bits == 0x3F80);
+    REQUIRE(Wav::Internal::convert<float, Wav::BFloat16>(1.0f + 0x3p-8f).bits == 0x3F82);
+    REQUIRE(Wav::Internal::convert<double, Wav::BFloat16>(1.0 + 0x1p-8 + 0x1p-40).bits == 0x3F81);
+    REQUIRE(std::isnan(static_cast<float>(Wav::Internal::convert<float, Wav::BFloat16>(NAN))));
+
+    // Subnormals round like any other value instead of flushing to zero
+    REQUIRE(Wav::Internal::convert<float, Wav::BFloat16>(1e-40f).bits == 0x0001);
+    REQUIRE(Wav::Internal::convert<float, Wav::BFloat16>(-1e-40f).bits == 0x8001);
+}
+
+TEST_CASE("Chunk index") {
+    std::string filePath = "tests/files/48000Hz_16bit_signed_1ch.wav";
+
+    // Append an odd sized 'LIST' chunk after the data chunk
+    std::ifstream file(filePath, std::ios::binary);
+    REQUIRE(file.is_open());
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::size_t dataEnd = bytes.size();
+    std::string info = "INFOICMT";
+    bytes += std::string("LIST") + std::string("\x0b\0\0\0", 4) + info + "ab" + '\0' + '\0';
+    uint32_t riffSize = bytes.size() - 8;
+    bytes.replace(4, 4, reinterpret_cast<const char*>(&riffSize), 4);
+    std::istringstream stream(bytes);
+
+    Wav::FileDescriptor descriptor;
+    Wav::ChunkIndex index;
+    Wav::infer(stream, descriptor, index);
+    REQUIRE(index.size() == 3);
+    REQUIRE(Wav::findChunk(index, "fmt ").has_value());
+    REQUIRE(Wav::findChunk(index, "data")->offset == descriptor.dataOffset);
+    REQUIRE(!Wav::findChunk(index, "bext").has_value());
+
+    auto list = Wav::findChunk(index, "LIST");
+    REQUIRE(list.has_value());
+    REQUIRE(list->offset == dataEnd + 8);
+    REQUIRE(list->size == 11);
+
+    std::vector<char> payload;
+    Wav::readChunk(stream, *list, payload);
+    REQUIRE(std::string(payload.data(), payload.size()) == info + "ab" + '\0');
+
+    // The stream is still usable for reading audio afterwards
+    auto x = std::vector<float>(descriptor.sampleCount);
+    Wav::read(stream, x);
+
+    // A trailing odd sized chunk without its pad byte is still indexed
+    std::istringstream unpadded(bytes.substr(0, bytes.size() - 1));
+    Wav::infer(unpadded, descriptor, index);
+    REQUIRE(index.size() == 3);
+    REQUIRE(Wav::findChunk(index, "LIST")->size == 11);
+    Wav::readChunk(unpadded, *Wav::findChunk(index, "LIST"), payload);
+    REQUIRE(std::string(payload.data(), payload.size()) == info + "ab" + '\0');
+
+    // Later 'data' chunks are indexed, but don't change what the descriptor points at
+    Wav::FileDescriptor first;
+    std::istringstream original(bytes);
+    Wav::infer(original, first);
+    std::string doubledBytes = bytes + std::string("data") + std::string("\x04\0\0\0", 4) + std::string(4, '\0');
+    riffSize = doubledBytes.size() - 8;
+    doubledBytes.replace(4, 4, reinterpret_cast<const char*>(&riffSize), 4);
+    std::istringstream doubled(doubledBytes);
+    Wav::infer(doubled, descriptor, index);
+    REQUIRE(index.size() == 4);
+    REQUIRE(descriptor.sampleCount == first.sampleCount);
+    REQUIRE(descriptor.dataOffset == first.dataOffset);
+
+    // Data after the RIFF form, like an ID3v1 tag, is not a chunk
+    std::istringstream tagged(bytes + "TAG" + std::string(125, 'x'));
+    Wav::infer(tagged, descriptor, index);
+    REQUIRE(index.size() == 3);
+    REQUIRE(!Wav::findChunk(index, "TAGx").has_value());
+
+    // Streaming writers leave the 'data' size at 0xFFFFFFFF, the recorded size is clamped to the stream
+    std::string streaming = bytes.substr(0, dataEnd);
+    streaming.replace(descriptor.dataOffset - 4, 4, std::string("\xff\xff\xff\xff", 4));
+    std::istringstream streamingStream(streaming);
+    Wav::infer(streamingStream, descriptor, index);
+    REQUIRE(index.size() == 2);
+    REQUIRE(Wav::findChunk(index, "data")->size == dataEnd - first.dataOffset);
+}